@@ -76,6 +76,8 @@ static SlruCtlData ClogCtlData;
 #define ClogCtl (&ClogCtlData)
 
 
+static void TransactionIdSetStatusBit(TransactionId xid, XidStatus status,
+						  XLogRecPtr lsn, int slotno);
 static int	ZeroCLOGPage(int pageno, bool writeXlog);
 static bool CLOGPagePrecedes(int page1, int page2);
 static void WriteZeroPageXlogRec(int pageno);
@@ -116,12 +118,7 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 	MIRRORED_LOCK_DECLARE;
 
 	int			pageno = TransactionIdToPage(xid);
-	int			byteno = TransactionIdToByte(xid);
-	int			bshift = TransactionIdToBIndex(xid) * CLOG_BITS_PER_XACT;
 	int			slotno;
-	char	   *byteptr;
-	char		byteval;
-	int			debugStatus;
 
 	Assert(status == TRANSACTION_STATUS_COMMITTED ||
 		   status == TRANSACTION_STATUS_ABORTED ||
@@ -129,7 +126,7 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(ClogCtl, pageno), LW_EXCLUSIVE);
 
 	/*
 	 * If we're doing an async commit (ie, lsn is valid), then we must wait
@@ -141,6 +138,81 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 	 * we think.  Hence, pass write_ok = XLogRecPtrIsInvalid(lsn).
 	 */
 	slotno = SimpleLruReadPage(ClogCtl, pageno, XLogRecPtrIsInvalid(lsn), xid);
+
+	TransactionIdSetStatusBit(xid, status, lsn, slotno);
+
+	LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
+
+	MIRRORED_UNLOCK;
+}
+
+/*
+ * Record the final state of several transactions in the commit log.
+ *
+ * The xids must be supplied in increasing order; this lets us batch all the
+ * updates that land on the same clog page under a single acquisition of
+ * that page's bank lock, instead of paying one exclusive lock hold per xid
+ * as a loop over TransactionIdSetStatus would.  Subtransaction commit is
+ * the main beneficiary: a tree with hundreds of subxids usually touches
+ * only one or two clog pages.
+ *
+ * Don't depend on this being atomic across pages; it's not.  The caller
+ * orders the xids so that any onlooker sees a consistent story (see
+ * TransactionIdCommitTree).
+ */
+void
+TransactionIdSetStatusMulti(int nxids, TransactionId *xids,
+							XidStatus status, XLogRecPtr lsn)
+{
+	MIRRORED_LOCK_DECLARE;
+
+	int			i = 0;
+
+	Assert(status == TRANSACTION_STATUS_COMMITTED ||
+		   status == TRANSACTION_STATUS_ABORTED ||
+		   status == TRANSACTION_STATUS_SUB_COMMITTED);
+
+	MIRRORED_LOCK;
+
+	while (i < nxids)
+	{
+		int			pageno = TransactionIdToPage(xids[i]);
+		int			j = i + 1;
+		int			slotno;
+
+		while (j < nxids && TransactionIdToPage(xids[j]) == pageno)
+			j++;
+
+		LWLockAcquire(SimpleLruGetBankLock(ClogCtl, pageno), LW_EXCLUSIVE);
+
+		/* write_ok rationale is the same as in TransactionIdSetStatus */
+		slotno = SimpleLruReadPage(ClogCtl, pageno, XLogRecPtrIsInvalid(lsn),
+								   xids[i]);
+
+		for (; i < j; i++)
+			TransactionIdSetStatusBit(xids[i], status, lsn, slotno);
+
+		LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
+	}
+
+	MIRRORED_UNLOCK;
+}
+
+/*
+ * Set the status bits (and the group LSN, if relevant) for one xid whose
+ * clog page is already present in the given slot.  The bank lock covering
+ * the page must be held in exclusive mode.
+ */
+static void
+TransactionIdSetStatusBit(TransactionId xid, XidStatus status, XLogRecPtr lsn,
+						  int slotno)
+{
+	int			byteno = TransactionIdToByte(xid);
+	int			bshift = TransactionIdToBIndex(xid) * CLOG_BITS_PER_XACT;
+	char	   *byteptr;
+	char		byteval;
+	int			debugStatus;
+
 	byteptr = ClogCtl->shared->page_buffer[slotno] + byteno;
 
 	debugStatus = ((*byteptr >> bshift) & CLOG_XACT_BITMASK);
@@ -149,7 +221,7 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 		debugStatus != status)
 	{
 		elog(FATAL,"TransactionIdSetStatus invalid for transaction %u current status '%s' (0x%x) and new status '%s' (0x%x)",
-			 xid, 
+			 xid,
 			 XidStatus_Name(debugStatus),
 			 debugStatus,
 			 XidStatus_Name(status),
@@ -168,7 +240,7 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 	byteval |= (status << bshift);
 	*byteptr = byteval;
 
-	ClogCtl->shared->page_dirty[slotno] = true;
+	ClogCtl->shared->slot_meta[slotno].dirty = true;
 
 	/*
 	 * Update the group LSN if the transaction completion LSN is higher.
@@ -185,10 +257,6 @@ TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn)
 		if (XLByteLT(ClogCtl->shared->group_lsn[lsnindex], lsn))
 			ClogCtl->shared->group_lsn[lsnindex] = lsn;
 	}
-
-	LWLockRelease(CLogControlLock);
-
-	MIRRORED_UNLOCK;
 }
 
 /*
@@ -231,7 +299,7 @@ TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn)
 	lsnindex = GetLSNIndex(slotno, xid);
 	*lsn = ClogCtl->shared->group_lsn[lsnindex];
 
-	LWLockRelease(CLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
 
 	MIRRORED_UNLOCK;
 
@@ -278,7 +346,7 @@ InRecoveryTransactionIdGetStatus(TransactionId xid, bool *valid)
 
   status = (*byteptr >> bshift) & CLOG_XACT_BITMASK;
 
-  LWLockRelease(CLogControlLock);
+  LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
 
   MIRRORED_UNLOCK;
 
@@ -318,6 +386,8 @@ CLOGScanForPrevStatus(
 
 	while (true)
 	{
+		LWLockId	bankLock;
+
 		pageno = TransactionIdToPage(highXid);
 
 		/*
@@ -327,14 +397,15 @@ CLOGScanForPrevStatus(
 		if (lowXid == InvalidTransactionId)
 			lowXid = FirstNormalTransactionId;
 
-		LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+		bankLock = SimpleLruGetBankLock(ClogCtl, pageno);
+		LWLockAcquire(bankLock, LW_EXCLUSIVE);
 
 		/*
 		 * Peek to see if page exists.
 		 */
 		if (!SimpleLruPageExists(ClogCtl, pageno))
 		{
-			LWLockRelease(CLogControlLock);
+			LWLockRelease(bankLock);
 
 			MIRRORED_UNLOCK;
 
@@ -354,7 +425,7 @@ CLOGScanForPrevStatus(
 
 			if (*status != TRANSACTION_STATUS_IN_PROGRESS)
 			{
-				LWLockRelease(CLogControlLock);
+				LWLockRelease(bankLock);
 
 				MIRRORED_UNLOCK;
 
@@ -363,7 +434,7 @@ CLOGScanForPrevStatus(
 			}
 		}
 
-		LWLockRelease(CLogControlLock);
+		LWLockRelease(bankLock);
 
 		if (lowXid == FirstNormalTransactionId)
 		{
@@ -422,7 +493,7 @@ CLOGShmemInit(void)
 {
 	ClogCtl->PagePrecedes = CLOGPagePrecedes;
 	SimpleLruInit(ClogCtl, "CLOG Ctl", NUM_CLOG_BUFFERS, CLOG_LSNS_PER_PAGE,
-				  CLogControlLock, "pg_clog");
+				  "pg_clog");
 }
 
 /*
@@ -440,16 +511,16 @@ BootStrapCLOG(void)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(ClogCtl, 0), LW_EXCLUSIVE);
 
 	/* Create and zero the first page of the commit log */
 	slotno = ZeroCLOGPage(0, false);
 
 	/* Make sure it's written out */
 	SimpleLruWritePage(ClogCtl, slotno, NULL);
-	Assert(!ClogCtl->shared->page_dirty[slotno]);
+	Assert(!ClogCtl->shared->slot_meta[slotno].dirty);
 
-	LWLockRelease(CLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(ClogCtl, 0));
 
 	MIRRORED_UNLOCK;
 }
@@ -461,7 +532,7 @@ BootStrapCLOG(void)
  * The page is not actually written, just set up in shared memory.
  * The slot number of the new page is returned.
  *
- * Control lock must be held at entry, and will be held at exit.
+ * The page's bank lock must be held at entry, and will be held at exit.
  */
 static int
 ZeroCLOGPage(int pageno, bool writeXlog)
@@ -496,7 +567,7 @@ StartupCLOG(void)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(ClogCtl, pageno), LW_EXCLUSIVE);
 
 	/*
 	 * Initialize our idea of the latest page number.
@@ -530,10 +601,10 @@ StartupCLOG(void)
 		/* Zero the rest of the page */
 		MemSet(byteptr + 1, 0, BLCKSZ - byteno - 1);
 
-		ClogCtl->shared->page_dirty[slotno] = true;
+		ClogCtl->shared->slot_meta[slotno].dirty = true;
 	}
 
-	LWLockRelease(CLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
 
 	MIRRORED_UNLOCK;
 }
@@ -598,12 +669,12 @@ ExtendCLOG(TransactionId newestXact)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(ClogCtl, pageno), LW_EXCLUSIVE);
 
 	/* Zero the page and make an XLOG entry about it */
 	ZeroCLOGPage(pageno, true);
 
-	LWLockRelease(CLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
 
 	MIRRORED_UNLOCK;
 }
@@ -734,13 +805,13 @@ clog_redo(XLogRecPtr beginLoc, XLogRecPtr lsn, XLogRecord *record)
 
 		memcpy(&pageno, XLogRecGetData(record), sizeof(int));
 
-		LWLockAcquire(CLogControlLock, LW_EXCLUSIVE);
+		LWLockAcquire(SimpleLruGetBankLock(ClogCtl, pageno), LW_EXCLUSIVE);
 
 		slotno = ZeroCLOGPage(pageno, false);
 		SimpleLruWritePage(ClogCtl, slotno, NULL);
-		Assert(!ClogCtl->shared->page_dirty[slotno]);
+		Assert(!ClogCtl->shared->slot_meta[slotno].dirty);
 
-		LWLockRelease(CLogControlLock);
+		LWLockRelease(SimpleLruGetBankLock(ClogCtl, pageno));
 	}
 	else if (info == CLOG_TRUNCATE)
 	{
@@ -100,8 +100,8 @@ DistributedLog_SetCommitted(
 	bool alreadyThere = false;
 
 	MIRRORED_LOCK;
-	
-	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+
+	LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, page), LW_EXCLUSIVE);
 
 	if (isRedo)
 	{
@@ -140,14 +140,14 @@ DistributedLog_SetCommitted(
 		ptr->distribTimeStamp = distribTimeStamp;
 		ptr->distribXid = distribXid;
 		
-		DistributedLogCtl->shared->page_dirty[slotno] = true;
+		DistributedLogCtl->shared->slot_meta[slotno].dirty = true;
 	}
-	
-	LWLockRelease(DistributedLogControlLock);
+
+	LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, page));
 
 	MIRRORED_UNLOCK;
-	
-	elog((Debug_print_full_dtm ? LOG : DEBUG5), 
+
+	elog((Debug_print_full_dtm ? LOG : DEBUG5),
 		 "DistributedLog_SetCommitted with local xid = %d (page = %d, entryno = %d) and distributed transaction xid = %u (timestamp = %u) status = %s",
 		 localXid, page, entryno, distribXid, distribTimeStamp,
 		 (alreadyThere ? "already there" : "set"));
@@ -173,6 +173,11 @@ DistributedLog_CommittedCheck(
 
 	MIRRORED_LOCK;
 
+	/*
+	 * DistributedLogControlLock guards the highestUnusedPage fields of
+	 * DistributedLogShared; the SLRU page itself is protected by its bank
+	 * lock.  Keep the acquisition order control lock first, then bank lock.
+	 */
 	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
 
 	if (DistributedLogShared->knowHighestUnusedPage &&
@@ -190,7 +195,9 @@ DistributedLog_CommittedCheck(
 
 		return false;
 	}
-	
+
+	LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, page), LW_EXCLUSIVE);
+
 	/*
 	 * Peek to see if page exists.
 	 */
@@ -206,7 +213,8 @@ DistributedLog_CommittedCheck(
 			DistributedLogShared->knowHighestUnusedPage = true;
 			DistributedLogShared->highestUnusedPage = page;
 		}
-		
+
+		LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, page));
 		LWLockRelease(DistributedLogControlLock);
 
 		MIRRORED_UNLOCK;
@@ -216,13 +224,14 @@ DistributedLog_CommittedCheck(
 
 		return false;
 	}
-		
+
 	slotno = SimpleLruReadPage(DistributedLogCtl, page, true, localXid);
 	ptr = (DistributedLogEntry *) DistributedLogCtl->shared->page_buffer[slotno];
 	ptr += entryno;
 	*distribTimeStamp = ptr->distribTimeStamp;
 	*distribXid = ptr->distribXid;
 	ptr = NULL;
+	LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, page));
 	LWLockRelease(DistributedLogControlLock);
 
 	MIRRORED_UNLOCK;
@@ -290,14 +299,15 @@ DistributedLog_ScanForPrevCommitted(
 		if (lowXid == InvalidTransactionId)
 			lowXid = FirstNormalTransactionId;
 
-		LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+		LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, pageno),
+					  LW_EXCLUSIVE);
 
 		/*
 		 * Peek to see if page exists.
 		 */
 		if (!SimpleLruPageExists(DistributedLogCtl, pageno))
 		{
-			LWLockRelease(DistributedLogControlLock);
+			LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, pageno));
 
 			MIRRORED_UNLOCK;
 
@@ -306,14 +316,14 @@ DistributedLog_ScanForPrevCommitted(
 			*distribXid = 0;
 			return false;
 		}
-			
+
 		slotno = SimpleLruReadPage(DistributedLogCtl, pageno, true, highXid);
 
 		for (xid = highXid; xid >= lowXid; xid--)
 		{
 			int						entryno = TransactionIdToEntry(xid);
 			DistributedLogEntry 	*ptr;
-			
+
 			ptr = (DistributedLogEntry *) DistributedLogCtl->shared->page_buffer[slotno];
 			ptr += entryno;
 
@@ -322,7 +332,7 @@ DistributedLog_ScanForPrevCommitted(
 				*indexXid = xid;
 				*distribTimeStamp = ptr->distribTimeStamp;
 				*distribXid = ptr->distribXid;
-				LWLockRelease(DistributedLogControlLock);
+				LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, pageno));
 
 				MIRRORED_UNLOCK;
 
@@ -330,7 +340,7 @@ DistributedLog_ScanForPrevCommitted(
 			}
 		}
 
-		LWLockRelease(DistributedLogControlLock);
+		LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, pageno));
 
 		if (lowXid == FirstNormalTransactionId)
 		{
@@ -379,7 +389,7 @@ DistributedLog_ShmemInit(void)
 	/* Set up SLRU for the distributed log. */
 	DistributedLogCtl->PagePrecedes = DistributedLog_PagePrecedes;
 	SimpleLruInit(DistributedLogCtl, "DistributedLogCtl", NUM_DISTRIBUTEDLOG_BUFFERS, 0,
-				  DistributedLogControlLock, DISTRIBUTEDLOG_DIR);
+				  DISTRIBUTEDLOG_DIR);
 
 	/* Create or attach to the shared structure */
 	DistributedLogShared = 
@@ -413,16 +423,16 @@ DistributedLog_BootStrap(void)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, 0), LW_EXCLUSIVE);
 
 	/* Create and zero the first page of the commit log */
 	slotno = DistributedLog_ZeroPage(0, false);
 
 	/* Make sure it's written out */
 	SimpleLruWritePage(DistributedLogCtl, slotno, NULL);
-	Assert(!DistributedLogCtl->shared->page_dirty[slotno]);
+	Assert(!DistributedLogCtl->shared->slot_meta[slotno].dirty);
 
-	LWLockRelease(DistributedLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, 0));
 
 	MIRRORED_UNLOCK;
 }
@@ -434,7 +444,7 @@ DistributedLog_BootStrap(void)
  * The page is not actually written, just set up in shared memory.
  * The slot number of the new page is returned.
  *
- * Control lock must be held at entry, and will be held at exit.
+ * The page's bank lock must be held at entry, and will be held at exit.
  */
 static int
 DistributedLog_ZeroPage(int page, bool writeXlog)
@@ -482,10 +492,11 @@ DistributedLog_Startup(
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, endPage),
+				  LW_EXCLUSIVE);
 
 	elog((Debug_print_full_dtm ? LOG : DEBUG5),
-		 "DistributedLog_Startup startPage %d, endPage %d", 
+		 "DistributedLog_Startup startPage %d, endPage %d",
 		 startPage, endPage);
 
 	/*
@@ -522,10 +533,10 @@ DistributedLog_Startup(
 		remainingEntries = ENTRIES_PER_PAGE - entryno;
 		MemSet(ptr, 0, remainingEntries * sizeof(DistributedLogEntry));
 
-		DistributedLogCtl->shared->page_dirty[slotno] = true;
+		DistributedLogCtl->shared->slot_meta[slotno].dirty = true;
 	}
 
-	LWLockRelease(DistributedLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, endPage));
 
 	MIRRORED_UNLOCK;
 }
@@ -600,12 +611,12 @@ DistributedLog_Extend(TransactionId newestXact)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, page), LW_EXCLUSIVE);
 
 	/* Zero the page and make an XLOG entry about it */
 	DistributedLog_ZeroPage(page, true);
 
-	LWLockRelease(DistributedLogControlLock);
+	LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, page));
 
 	MIRRORED_UNLOCK;
 	
@@ -670,8 +681,12 @@ DistributedLog_Truncate(TransactionId oldestXid)
 	/* Write XLOG record and flush XLOG to disk */
 	DistributedLog_WriteTruncateXlogRec(cutoffPage);
 
-	/* Now we can remove the old DistributedLog segment(s) */
-	SimpleLruTruncateWithLock(DistributedLogCtl, cutoffPage); /* we already hold the lock */
+	/*
+	 * Now we can remove the old DistributedLog segment(s).  The bank locks
+	 * are taken internally; DistributedLogControlLock (which we hold, to
+	 * guard oldestXid) is always acquired before any bank lock.
+	 */
+	SimpleLruTruncate(DistributedLogCtl, cutoffPage);
 	
 	elog((Debug_print_full_dtm ? LOG : DEBUG5), 
 		 "DistributedLog_Truncate with oldest local xid = %d to cutoff page = %d",
@@ -772,13 +787,14 @@ DistributedLog_redo(XLogRecPtr beginLoc, XLogRecPtr lsn, XLogRecord *record)
 			 "Redo DISTRIBUTEDLOG_ZEROPAGE page %d",
 			 page);
 
-		LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+		LWLockAcquire(SimpleLruGetBankLock(DistributedLogCtl, page),
+					  LW_EXCLUSIVE);
 
 		slotno = DistributedLog_ZeroPage(page, false);
 		SimpleLruWritePage(DistributedLogCtl, slotno, NULL);
-		Assert(!DistributedLogCtl->shared->page_dirty[slotno]);
+		Assert(!DistributedLogCtl->shared->slot_meta[slotno].dirty);
 
-		LWLockRelease(DistributedLogControlLock);
+		LWLockRelease(SimpleLruGetBankLock(DistributedLogCtl, page));
 		
 		elog((Debug_print_full_dtm ? LOG : DEBUG5), 
 			 "DistributedLog_redo zero page = %d",
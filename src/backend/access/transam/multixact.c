@@ -101,10 +101,10 @@ static SlruCtlData MultiXactMemberCtlData;
 
 /*
  * MultiXact state shared across all backends.	All this state is protected
- * by MultiXactGenLock.  (We also use MultiXactOffsetControlLock and
- * MultiXactMemberControlLock to guard accesses to the two sets of SLRU
- * buffers.  For concurrency's sake, we avoid holding more than one of these
- * locks at a time.)
+ * by MultiXactGenLock.  (The two sets of SLRU buffers are guarded by the
+ * per-bank SLRU control locks, obtained via SimpleLruGetBankLock().  For
+ * concurrency's sake, we avoid holding more than one of these locks at a
+ * time.)
  */
 typedef struct MultiXactStateData
 {
@@ -759,11 +759,12 @@ RecordNewMultiXact(MultiXactId multi, MultiXactOffset offset,
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
-
 	pageno = MultiXactIdToOffsetPage(multi);
 	entryno = MultiXactIdToOffsetEntry(multi);
 
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno),
+				  LW_EXCLUSIVE);
+
 	/*
 	 * Note: we pass the MultiXactId to SimpleLruReadPage as the "transaction"
 	 * to complain about if there's any I/O error.  This is kinda bogus, but
@@ -777,12 +778,10 @@ RecordNewMultiXact(MultiXactId multi, MultiXactOffset offset,
 
 	*offptr = offset;
 
-	MultiXactOffsetCtl->shared->page_dirty[slotno] = true;
+	MultiXactOffsetCtl->shared->slot_meta[slotno].dirty = true;
 
 	/* Exchange our lock */
-	LWLockRelease(MultiXactOffsetControlLock);
-
-	LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 
 	prev_pageno = -1;
 
@@ -795,6 +794,16 @@ RecordNewMultiXact(MultiXactId multi, MultiXactOffset offset,
 
 		if (pageno != prev_pageno)
 		{
+			/*
+			 * Swap to the bank lock of the new page; successive member
+			 * pages may live in different banks.
+			 */
+			if (prev_pageno >= 0)
+				LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl,
+												   prev_pageno));
+			LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, pageno),
+						  LW_EXCLUSIVE);
+
 			slotno = SimpleLruReadPage(MultiXactMemberCtl, pageno, true, multi);
 			prev_pageno = pageno;
 		}
@@ -805,10 +814,11 @@ RecordNewMultiXact(MultiXactId multi, MultiXactOffset offset,
 
 		*memberptr = xids[i];
 
-		MultiXactMemberCtl->shared->page_dirty[slotno] = true;
+		MultiXactMemberCtl->shared->slot_meta[slotno].dirty = true;
 	}
 
-	LWLockRelease(MultiXactMemberControlLock);
+	if (prev_pageno >= 0)
+		LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, prev_pageno));
 
 	MIRRORED_UNLOCK;
 }
@@ -1022,11 +1032,12 @@ GetMultiXactIdMembers(MultiXactId multi, TransactionId **xids)
 	 * time on every multixact creation.
 	 */
 retry:
-	LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
-
 	pageno = MultiXactIdToOffsetPage(multi);
 	entryno = MultiXactIdToOffsetEntry(multi);
 
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno),
+				  LW_EXCLUSIVE);
+
 	slotno = SimpleLruReadPage(MultiXactOffsetCtl, pageno, true, multi);
 	offptr = (MultiXactOffset *) MultiXactOffsetCtl->shared->page_buffer[slotno];
 	offptr += entryno;
@@ -1059,7 +1070,21 @@ retry:
 		entryno = MultiXactIdToOffsetEntry(tmpMXact);
 
 		if (pageno != prev_pageno)
+		{
+			LWLockId	nextlock = SimpleLruGetBankLock(MultiXactOffsetCtl,
+														pageno);
+
+			/* The next page may hash to a different bank */
+			if (nextlock != SimpleLruGetBankLock(MultiXactOffsetCtl,
+												 prev_pageno))
+			{
+				LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl,
+												   prev_pageno));
+				LWLockAcquire(nextlock, LW_EXCLUSIVE);
+			}
+
 			slotno = SimpleLruReadPage(MultiXactOffsetCtl, pageno, true, tmpMXact);
+		}
 
 		offptr = (MultiXactOffset *) MultiXactOffsetCtl->shared->page_buffer[slotno];
 		offptr += entryno;
@@ -1068,7 +1093,7 @@ retry:
 		if (nextMXOffset == 0)
 		{
 			/* Corner case 2: next multixact is still being filled in */
-			LWLockRelease(MultiXactOffsetControlLock);
+			LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 			pg_usleep(1000L);
 			goto retry;
 		}
@@ -1076,14 +1101,12 @@ retry:
 		length = nextMXOffset - offset;
 	}
 
-	LWLockRelease(MultiXactOffsetControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 
 	ptr = (TransactionId *) palloc(length * sizeof(TransactionId));
 	*xids = ptr;
 
 	/* Now get the members themselves. */
-	LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
-
 	truelength = 0;
 	prev_pageno = -1;
 	for (i = 0; i < length; i++, offset++)
@@ -1095,6 +1118,13 @@ retry:
 
 		if (pageno != prev_pageno)
 		{
+			/* Swap to the bank lock of the new page if necessary */
+			if (prev_pageno >= 0)
+				LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl,
+												   prev_pageno));
+			LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, pageno),
+						  LW_EXCLUSIVE);
+
 			slotno = SimpleLruReadPage(MultiXactMemberCtl, pageno, true, multi);
 			prev_pageno = pageno;
 		}
@@ -1113,7 +1143,8 @@ retry:
 		ptr[truelength++] = *xactptr;
 	}
 
-	LWLockRelease(MultiXactMemberControlLock);
+	if (prev_pageno >= 0)
+		LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, prev_pageno));
 
 	MIRRORED_UNLOCK;
 
@@ -1456,10 +1487,10 @@ MultiXactShmemInit(void)
 
 	SimpleLruInit(MultiXactOffsetCtl,
 				  "MultiXactOffset Ctl", NUM_MXACTOFFSET_BUFFERS, 0,
-				  MultiXactOffsetControlLock, MULTIXACT_OFFSETS_DIR);
+				  MULTIXACT_OFFSETS_DIR);
 	SimpleLruInit(MultiXactMemberCtl,
 				  "MultiXactMember Ctl", NUM_MXACTMEMBER_BUFFERS, 0,
-				  MultiXactMemberControlLock, MULTIXACT_MEMBERS_DIR);
+				  MULTIXACT_MEMBERS_DIR);
 
 	/* Initialize our shared state struct */
 	MultiXactState = ShmemInitStruct("Shared MultiXact State",
@@ -1497,27 +1528,27 @@ BootStrapMultiXact(void)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, 0), LW_EXCLUSIVE);
 
 	/* Create and zero the first page of the offsets log */
 	slotno = ZeroMultiXactOffsetPage(0, false);
 
 	/* Make sure it's written out */
 	SimpleLruWritePage(MultiXactOffsetCtl, slotno, NULL);
-	Assert(!MultiXactOffsetCtl->shared->page_dirty[slotno]);
+	Assert(!MultiXactOffsetCtl->shared->slot_meta[slotno].dirty);
 
-	LWLockRelease(MultiXactOffsetControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, 0));
 
-	LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, 0), LW_EXCLUSIVE);
 
 	/* Create and zero the first page of the members log */
 	slotno = ZeroMultiXactMemberPage(0, false);
 
 	/* Make sure it's written out */
 	SimpleLruWritePage(MultiXactMemberCtl, slotno, NULL);
-	Assert(!MultiXactMemberCtl->shared->page_dirty[slotno]);
+	Assert(!MultiXactMemberCtl->shared->slot_meta[slotno].dirty);
 
-	LWLockRelease(MultiXactMemberControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, 0));
 
 	MIRRORED_UNLOCK;
 }
@@ -1529,7 +1560,7 @@ BootStrapMultiXact(void)
  * The page is not actually written, just set up in shared memory.
  * The slot number of the new page is returned.
  *
- * Control lock must be held at entry, and will be held at exit.
+ * The page's bank lock must be held at entry, and will be held at exit.
  */
 static int
 ZeroMultiXactOffsetPage(int pageno, bool writeXlog)
@@ -1595,12 +1626,14 @@ StartupMultiXact(void)
 	MIRRORED_LOCK;
 
 	/* Clean up offsets state */
-	LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
+	pageno = MultiXactIdToOffsetPage(multi);
+
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno),
+				  LW_EXCLUSIVE);
 
 	/*
 	 * Initialize our idea of the latest page number.
 	 */
-	pageno = MultiXactIdToOffsetPage(multi);
 	MultiXactOffsetCtl->shared->latest_page_number = pageno;
 
 	/*
@@ -1619,18 +1652,20 @@ StartupMultiXact(void)
 
 		MemSet(offptr, 0, BLCKSZ - (entryno * sizeof(MultiXactOffset)));
 
-		MultiXactOffsetCtl->shared->page_dirty[slotno] = true;
+		MultiXactOffsetCtl->shared->slot_meta[slotno].dirty = true;
 	}
 
-	LWLockRelease(MultiXactOffsetControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 
 	/* And the same for members */
-	LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
+	pageno = MXOffsetToMemberPage(offset);
+
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, pageno),
+				  LW_EXCLUSIVE);
 
 	/*
 	 * Initialize our idea of the latest page number.
 	 */
-	pageno = MXOffsetToMemberPage(offset);
 	MultiXactMemberCtl->shared->latest_page_number = pageno;
 
 	/*
@@ -1649,10 +1684,10 @@ StartupMultiXact(void)
 
 		MemSet(xidptr, 0, BLCKSZ - (entryno * sizeof(TransactionId)));
 
-		MultiXactMemberCtl->shared->page_dirty[slotno] = true;
+		MultiXactMemberCtl->shared->slot_meta[slotno].dirty = true;
 	}
 
-	LWLockRelease(MultiXactMemberControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, pageno));
 
 	MIRRORED_UNLOCK;
 
@@ -1802,12 +1837,13 @@ ExtendMultiXactOffset(MultiXactId multi)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno),
+				  LW_EXCLUSIVE);
 
 	/* Zero the page and make an XLOG entry about it */
 	ZeroMultiXactOffsetPage(pageno, true);
 
-	LWLockRelease(MultiXactOffsetControlLock);
+	LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 
 	MIRRORED_UNLOCK;
 }
@@ -1846,12 +1882,13 @@ ExtendMultiXactMember(MultiXactOffset offset, int nmembers)
 
 			pageno = MXOffsetToMemberPage(offset);
 
-			LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
+			LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, pageno),
+						  LW_EXCLUSIVE);
 
 			/* Zero the page and make an XLOG entry about it */
 			ZeroMultiXactMemberPage(pageno, true);
 
-			LWLockRelease(MultiXactMemberControlLock);
+			LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, pageno));
 		}
 
 		/* Advance to next page (OK if nmembers goes negative) */
@@ -1958,7 +1995,7 @@ TruncateMultiXact(void)
 		offptr += entryno;
 		oldestOffset = *offptr;
 
-		LWLockRelease(MultiXactOffsetControlLock);
+		LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 	}
 
 	/*
@@ -2087,13 +2124,14 @@ multixact_redo(XLogRecPtr beginLoc __attribute__((unused)), XLogRecPtr lsn __att
 
 		memcpy(&pageno, XLogRecGetData(record), sizeof(int));
 
-		LWLockAcquire(MultiXactOffsetControlLock, LW_EXCLUSIVE);
+		LWLockAcquire(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno),
+					  LW_EXCLUSIVE);
 
 		slotno = ZeroMultiXactOffsetPage(pageno, false);
 		SimpleLruWritePage(MultiXactOffsetCtl, slotno, NULL);
-		Assert(!MultiXactOffsetCtl->shared->page_dirty[slotno]);
+		Assert(!MultiXactOffsetCtl->shared->slot_meta[slotno].dirty);
 
-		LWLockRelease(MultiXactOffsetControlLock);
+		LWLockRelease(SimpleLruGetBankLock(MultiXactOffsetCtl, pageno));
 	}
 	else if (info == XLOG_MULTIXACT_ZERO_MEM_PAGE)
 	{
@@ -2102,13 +2140,14 @@ multixact_redo(XLogRecPtr beginLoc __attribute__((unused)), XLogRecPtr lsn __att
 
 		memcpy(&pageno, XLogRecGetData(record), sizeof(int));
 
-		LWLockAcquire(MultiXactMemberControlLock, LW_EXCLUSIVE);
+		LWLockAcquire(SimpleLruGetBankLock(MultiXactMemberCtl, pageno),
+					  LW_EXCLUSIVE);
 
 		slotno = ZeroMultiXactMemberPage(pageno, false);
 		SimpleLruWritePage(MultiXactMemberCtl, slotno, NULL);
-		Assert(!MultiXactMemberCtl->shared->page_dirty[slotno]);
+		Assert(!MultiXactMemberCtl->shared->slot_meta[slotno].dirty);
 
-		LWLockRelease(MultiXactMemberControlLock);
+		LWLockRelease(SimpleLruGetBankLock(MultiXactMemberCtl, pageno));
 	}
 	else if (info == XLOG_MULTIXACT_CREATE_ID)
 	{
@@ -103,7 +103,7 @@ SubTransGetData(TransactionId xid, SubTransData* subData)
 		subData->topMostParent = xid;
 	}
 
-	LWLockRelease(SubtransControlLock);
+	LWLockRelease(SimpleLruGetBankLock(SubTransCtl, pageno));
 
 	MIRRORED_UNLOCK;
 
@@ -139,7 +139,7 @@ SubTransSetParent(TransactionId xid, TransactionId parent)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(SubtransControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(SubTransCtl, pageno), LW_EXCLUSIVE);
 
 	slotno = SimpleLruReadPage(SubTransCtl, pageno, true, xid);
 	ptr = (SubTransData *) SubTransCtl->shared->page_buffer[slotno];
@@ -152,9 +152,9 @@ SubTransSetParent(TransactionId xid, TransactionId parent)
 	ptr->parent = parent;
 	ptr->topMostParent = subData.topMostParent;
 
-	SubTransCtl->shared->page_dirty[slotno] = true;
+	SubTransCtl->shared->slot_meta[slotno].dirty = true;
 
-	LWLockRelease(SubtransControlLock);
+	LWLockRelease(SimpleLruGetBankLock(SubTransCtl, pageno));
 
 	MIRRORED_UNLOCK;
 }
@@ -201,7 +201,7 @@ SUBTRANSShmemInit(void)
 {
 	SubTransCtl->PagePrecedes = SubTransPagePrecedes;
 	SimpleLruInit(SubTransCtl, "SUBTRANS Ctl", NUM_SUBTRANS_BUFFERS, 0,
-				  SubtransControlLock, SUBTRANS_DIR);
+				  SUBTRANS_DIR);
 	/* Override default assumption that writes should be fsync'd */
 	SubTransCtl->do_fsync = false;
 }
@@ -225,16 +225,16 @@ BootStrapSUBTRANS(void)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(SubtransControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(SubTransCtl, 0), LW_EXCLUSIVE);
 
 	/* Create and zero the first page of the subtrans log */
 	slotno = ZeroSUBTRANSPage(0);
 
 	/* Make sure it's written out */
 	SimpleLruWritePage(SubTransCtl, slotno, NULL);
-	Assert(!SubTransCtl->shared->page_dirty[slotno]);
+	Assert(!SubTransCtl->shared->slot_meta[slotno].dirty);
 
-	LWLockRelease(SubtransControlLock);
+	LWLockRelease(SimpleLruGetBankLock(SubTransCtl, 0));
 
 	MIRRORED_UNLOCK;
 }
@@ -245,7 +245,7 @@ BootStrapSUBTRANS(void)
  * The page is not actually written, just set up in shared memory.
  * The slot number of the new page is returned.
  *
- * Control lock must be held at entry, and will be held at exit.
+ * The page's bank lock must be held at entry, and will be held at exit.
  */
 static int
 ZeroSUBTRANSPage(int pageno)
@@ -287,19 +287,21 @@ StartupSUBTRANS(TransactionId oldestActiveXID)
 
 	MIRRORED_LOCK;
 
-	LWLockAcquire(SubtransControlLock, LW_EXCLUSIVE);
-
 	startPage = TransactionIdToPage(oldestActiveXID);
 	endPage = TransactionIdToPage(ShmemVariableCache->nextXid);
 
+	/* Each page may live in a different bank, so lock page by page */
 	while (startPage != endPage)
 	{
+		LWLockAcquire(SimpleLruGetBankLock(SubTransCtl, startPage),
+					  LW_EXCLUSIVE);
 		(void) ZeroSUBTRANSPage(startPage);
+		LWLockRelease(SimpleLruGetBankLock(SubTransCtl, startPage));
 		startPage++;
 	}
+	LWLockAcquire(SimpleLruGetBankLock(SubTransCtl, startPage), LW_EXCLUSIVE);
 	(void) ZeroSUBTRANSPage(startPage);
-
-	LWLockRelease(SubtransControlLock);
+	LWLockRelease(SimpleLruGetBankLock(SubTransCtl, startPage));
 
 	MIRRORED_UNLOCK;
 }
@@ -375,12 +377,12 @@ ExtendSUBTRANS(TransactionId newestXact)
 
 	pageno = TransactionIdToPage(newestXact);
 
-	LWLockAcquire(SubtransControlLock, LW_EXCLUSIVE);
+	LWLockAcquire(SimpleLruGetBankLock(SubTransCtl, pageno), LW_EXCLUSIVE);
 
 	/* Zero the page */
 	ZeroSUBTRANSPage(pageno);
 
-	LWLockRelease(SubtransControlLock);
+	LWLockRelease(SimpleLruGetBankLock(SubTransCtl, pageno));
 }
 
 
@@ -50,13 +50,18 @@ static MPP_20426(void **state, TransactionId nextXid)
 	DistributedLogCtl->shared = (SlruShared) malloc(sizeof(SlruSharedData));
 	DistributedLogCtl->shared->page_buffer =
 			(char **) malloc(DtxLogStartupNumPage * sizeof(char *));
-	DistributedLogCtl->shared->page_dirty =
-			(bool *) malloc(DtxLogStartupNumPage * sizeof(bool));
+	DistributedLogCtl->shared->slot_meta =
+			(SlruSlotMeta *) malloc(DtxLogStartupNumPage * sizeof(SlruSlotMeta));
 	DistributedLogCtl->shared->page_buffer[0] = &pages[0];
 	DistributedLogCtl->shared->page_buffer[1] = &pages[BLCKSZ];
 	memset(pages, 0x7f, sizeof(pages));
 	memset(zeros, 0, sizeof(zeros));
 
+	/* Startup takes the bank lock of the page being zeroed */
+	expect_value_count(SimpleLruGetBankLock, ctl, DistributedLogCtl, 2);
+	expect_any_count(SimpleLruGetBankLock, pageno, 2);
+	will_return_count(SimpleLruGetBankLock, DistributedLogControlLock, 2);
+
 	expect_value(LWLockAcquire, lockid, DistributedLogControlLock);
 	expect_value(LWLockAcquire, mode, LW_EXCLUSIVE);
 	will_be_called(LWLockAcquire);
@@ -81,7 +86,7 @@ static MPP_20426(void **state, TransactionId nextXid)
 	bytes = TransactionIdToEntry(nextXid) * sizeof(DistributedLogEntry);
 	assert_memory_equal(&pages[bytes], zeros, BLCKSZ - bytes);
 
-	free(DistributedLogCtl->shared->page_dirty);
+	free(DistributedLogCtl->shared->slot_meta);
 	free(DistributedLogCtl->shared->page_buffer);
 	free(DistributedLogCtl->shared);
 }
@@ -121,17 +121,18 @@ TransactionLogUpdate(TransactionId transactionId,
  *
  * Update multiple transaction identifiers to a given status.
  * Don't depend on this being atomic; it's not.
+ *
+ * The clog layer batches xids that fall on the same clog page, so the
+ * whole set usually costs one or two lock acquisitions rather than one
+ * per xid.
  */
 static inline void
 TransactionLogMultiUpdate(int nxids, TransactionId *xids,
 						  XidStatus status, XLogRecPtr lsn)
 {
-	int			i;
-
 	Assert(nxids != 0);
 
-	for (i = 0; i < nxids; i++)
-		TransactionIdSetStatus(xids[i], status, lsn);
+	TransactionIdSetStatusMulti(nxids, xids, status, lsn);
 }
 
 
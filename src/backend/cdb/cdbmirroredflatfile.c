@@ -41,6 +41,8 @@ static int32 writeBufLen = 0;
 static char *writeBuf = NULL;
 static char *writeBufAligned = NULL;
 
+static bool MirroredFlatFile_FlushSend(MirroredFlatFileOpen *open);
+
 
 /*
  * The following two gucs
@@ -365,6 +367,22 @@ MirroredFlatFile_IsActive(
 	return open->isActive;
 }
 
+/*
+ * Kick off asynchronous writeback of the local side of a flat file.  A
+ * performance hint only (see FileStartWriteback); the mirror side needs
+ * nothing, since its writes are already in flight over the network.
+ */
+void
+MirroredFlatFile_StartWriteback(
+					   MirroredFlatFileOpen *open)
+{
+	Assert(open != NULL);
+	Assert(open->isActive);
+
+	if (!open->isMirrorRecovery)
+		FileStartWriteback(open->primaryFile);
+}
+
 /*
  * Flush a flat file.
  *
@@ -376,9 +394,27 @@ MirroredFlatFile_Flush(
 
 					   bool suppressError)
 
+{
+	if (MirroredFlatFile_FlushSend(open))
+		MirroredFlatFile_WaitForFlush(open->subDirectory,
+									  open->simpleFileName);
+
+	return 0;
+}
+
+/*
+ * Issue the flush for a flat file without waiting for the mirror to
+ * acknowledge it.  Returns true if a flush message was sent to the mirror,
+ * in which case the caller owes a later MirroredFlatFile_WaitForFlush for
+ * this file.  The local side (if any) is fsynced before returning.
+ */
+static bool
+MirroredFlatFile_FlushSend(
+						   MirroredFlatFileOpen *open)
+ /* The open struct. */
+
 {
 	bool		mirrorFlush = TRUE;
-	int			save_errno = 0;
 
 	Assert(open != NULL);
 	Assert(open->isActive);
@@ -404,26 +440,35 @@ MirroredFlatFile_Flush(
 			ereport(ERROR,
 					(errcode_for_file_access(),
 					 errmsg("could not fsync file \"%s\": %m", open->path)));
-
-		save_errno = errno;
 	}
 
-	if (mirrorFlush)
+	return mirrorFlush;
+}
+
+/*
+ * Wait for the mirror to acknowledge a previously sent flush of the given
+ * file.  The file is named rather than passed as an open struct so the
+ * wait can be issued after MirroredFlatFile_Close, which frees the struct.
+ */
+void
+MirroredFlatFile_WaitForFlush(
+							  char *subDirectory,
+
+							  char *simpleFileName)
+ /* The simple file name. */
+
+{
+	if (FileRepPrimary_IsOperationCompleted(
+											FileRep_GetFlatFileIdentifier(
+																		  subDirectory,
+																		  simpleFileName),
+											FileRepRelationTypeFlatFile) == FALSE)
 	{
-		if (FileRepPrimary_IsOperationCompleted(
-												FileRep_GetFlatFileIdentifier(
-																			  open->subDirectory,
-																			  open->simpleFileName),
-												FileRepRelationTypeFlatFile) == FALSE)
-		{
-			ereport(LOG,
-					(errmsg("could not fsync file on mirror '%s/%s' ",
-							open->subDirectory,
-							open->simpleFileName)));
-		}
+		ereport(LOG,
+				(errmsg("could not fsync file on mirror '%s/%s' ",
+						subDirectory,
+						simpleFileName)));
 	}
-
-	return save_errno;
 }
 
 /*
@@ -1033,6 +1078,15 @@ MirroredFlatFile_ReconcileXLogEof(
 	return status;
 }
 
+/*
+ * Size of the copy buffer used by MirrorFlatFile.  Copying in chunks much
+ * larger than BLCKSZ cuts the number of seek+read syscalls on the primary
+ * side and lets the file replication layer fill its messages completely;
+ * it chunks each append by its own message size internally, so there is
+ * nothing gained past a few hundred kilobytes.
+ */
+#define MIRROR_FLAT_FILE_COPY_BUFFER_LEN	(32 * BLCKSZ)
+
 /*
  *
  */
@@ -1040,6 +1094,23 @@ int
 MirrorFlatFile(
 			   char *subDirectory,
 			   char *simpleFileName)
+{
+	return MirrorFlatFileAsync(subDirectory, simpleFileName, NULL);
+}
+
+/*
+ * As MirrorFlatFile, except that when flushAckPending is non-NULL the
+ * final flush is only sent, not waited for; *flushAckPending reports
+ * whether the caller owes a MirroredFlatFile_WaitForFlush for this file.
+ * Copying a whole directory can then keep the next file streaming to the
+ * mirror while earlier flushes are still in flight, so the total wait is
+ * bounded by the slowest acknowledgement rather than their sum.
+ */
+int
+MirrorFlatFileAsync(
+			   char *subDirectory,
+			   char *simpleFileName,
+			   bool *flushAckPending)
 {
 	MirroredFlatFileOpen mirroredOpen;
 	MirroredFlatFileOpen primaryOpen;
@@ -1059,6 +1130,9 @@ MirrorFlatFile(
 	 */
 	MemSet(&mirroredOpen, 0, sizeof(MirroredFlatFileOpen));
 
+	if (flushAckPending)
+		*flushAckPending = false;
+
 	if (isTxnDir(subDirectory))
 	{
 		dir = makeRelativeToTxnFilespace(subDirectory);
@@ -1117,7 +1191,8 @@ MirrorFlatFile(
 		if (retval != 0)
 			break;
 
-		bufferLen = (Size) Min(BLCKSZ, endOffset - startOffset);
+		bufferLen = (Size) Min(MIRROR_FLAT_FILE_COPY_BUFFER_LEN,
+							   endOffset - startOffset);
 		buffer = (char *) palloc(bufferLen);
 
 		MemSet(buffer, 0, bufferLen);
@@ -1152,15 +1227,19 @@ MirrorFlatFile(
 
 			startOffset += bufferLen;
 
-			bufferLen = (Size) Min(BLCKSZ, endOffset - startOffset);
+			bufferLen = (Size) Min(MIRROR_FLAT_FILE_COPY_BUFFER_LEN,
+								   endOffset - startOffset);
 		} //while
 
 			if (retval != 0)
 			break;
 
-		retval = MirroredFlatFile_Flush(
-										&mirroredOpen,
-										 /* suppressError */ FALSE);
+		if (flushAckPending)
+			*flushAckPending = MirroredFlatFile_FlushSend(&mirroredOpen);
+		else
+			retval = MirroredFlatFile_Flush(
+											&mirroredOpen,
+											 /* suppressError */ FALSE);
 		if (retval != 0)
 			break;
 
@@ -1338,6 +1338,30 @@ FileSync(File file)
 	return returnCode;
 }
 
+/*
+ * Ask the kernel to start writing out a file's dirty pages, without waiting
+ * for the I/O to finish.  Issuing this for every file of a batch before
+ * fsyncing them lets the I/O scheduler work on all the files at once, so
+ * the fsyncs that follow mostly find their writeback already done.  This is
+ * purely a performance hint: errors are ignored here, since the subsequent
+ * fsync will report anything that actually matters.
+ */
+void
+FileStartWriteback(File file)
+{
+#ifdef SYNC_FILE_RANGE_WRITE
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FileStartWriteback: %d (%s)",
+			   file, VfdCache[file].fileName));
+
+	if (FileAccess(file) < 0)
+		return;
+
+	(void) sync_file_range(VfdCache[file].fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+}
+
 int64
 FileSeek(File file, int64 offset, int whence)
 {
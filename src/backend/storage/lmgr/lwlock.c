@@ -24,6 +24,7 @@
 #include "access/clog.h"
 #include "access/multixact.h"
 #include "access/distributedlog.h"
+#include "access/slru.h"
 #include "access/subtrans.h"
 #include "access/twophase.h"
 #include "miscadmin.h"
@@ -186,10 +187,10 @@ NumLWLocks(void)
 
 	/* subtrans.c needs one per SubTrans buffer */
 	numLocks += NUM_SUBTRANS_BUFFERS;
-    
+
     /* cdbtm.c needs one lock */
     numLocks++;
-    
+
     /* cdbfts.c needs one lock */
     numLocks++;
 
@@ -199,6 +200,13 @@ NumLWLocks(void)
 	/* cdbdistributedlog.c needs one per DistributedLog buffer */
 	numLocks += NUM_DISTRIBUTEDLOG_BUFFERS;
 
+	/* slru.c needs one bank lock per SLRU_BANK_SIZE buffers of each area */
+	numLocks += (NUM_CLOG_BUFFERS +
+				 NUM_SUBTRANS_BUFFERS +
+				 NUM_MXACTOFFSET_BUFFERS +
+				 NUM_MXACTMEMBER_BUFFERS +
+				 NUM_DISTRIBUTEDLOG_BUFFERS) / SLRU_BANK_SIZE;
+
 	/* sharedsnapshot.c needs one per shared snapshot slot */
 	numLocks += NUM_SHARED_SNAPSHOT_SLOTS;
     
@@ -28,11 +28,19 @@ typedef int XidStatus;
 #define TRANSACTION_STATUS_SUB_COMMITTED	0x03
 
 
-/* Number of SLRU buffers to use for clog */
-#define NUM_CLOG_BUFFERS	8
+/*
+ * Number of SLRU buffers to use for clog.  Must give more than one bank of
+ * SLRU_BANK_SIZE slots, or the per-bank control locks degenerate to a
+ * single lock and clog lookups serialize again; 32 buffers make four
+ * banks, so concurrent lookups of status pages in different banks do not
+ * contend.
+ */
+#define NUM_CLOG_BUFFERS	32
 
 
 extern void TransactionIdSetStatus(TransactionId xid, XidStatus status, XLogRecPtr lsn);
+extern void TransactionIdSetStatusMulti(int nxids, TransactionId *xids,
+							XidStatus status, XLogRecPtr lsn);
 extern XidStatus TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn);
 extern XidStatus InRecoveryTransactionIdGetStatus(TransactionId xid, bool *valid);
 
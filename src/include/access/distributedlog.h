@@ -42,8 +42,12 @@ typedef struct DistributedLogEntry
 
 } DistributedLogEntry;
 
-/* Number of SLRU buffers to use for the distributed log */
-#define NUM_DISTRIBUTEDLOG_BUFFERS	8
+/*
+ * Number of SLRU buffers to use for the distributed log.  Kept at several
+ * times SLRU_BANK_SIZE so the log gets multiple banks and their control
+ * locks actually partition (see NUM_CLOG_BUFFERS).
+ */
+#define NUM_DISTRIBUTEDLOG_BUFFERS	32
 
 extern void DistributedLog_SetCommitted(
 							TransactionId localXid,
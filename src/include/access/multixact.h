@@ -18,9 +18,13 @@
 
 #define MultiXactIdIsValid(multi) ((multi) != InvalidMultiXactId)
 
-/* Number of SLRU buffers to use for multixact */
-#define NUM_MXACTOFFSET_BUFFERS		8
-#define NUM_MXACTMEMBER_BUFFERS		16
+/*
+ * Number of SLRU buffers to use for multixact.  Both counts span multiple
+ * banks of SLRU_BANK_SIZE slots so the per-bank control locks actually
+ * partition (see NUM_CLOG_BUFFERS).
+ */
+#define NUM_MXACTOFFSET_BUFFERS		32
+#define NUM_MXACTMEMBER_BUFFERS		32
 
 /* ----------------
  *		multixact-related XLOG entries
@@ -15,6 +15,7 @@
 
 #include "access/xlogdefs.h"
 #include "storage/lwlock.h"
+#include "storage/spin.h"
 
 #define CLOG_DIR				"pg_clog"
 #define DISTRIBUTEDLOG_DIR		"pg_distributedlog"
@@ -25,6 +26,12 @@
 
 #define SLRU_FILENAME_LEN		4     /* SLRU filenames are 4 characters each */
 #define SLRU_CHECKSUM_FILENAME 	"slru_checksum_file"
+
+/*
+ * Size of the checksum string buffers.  The checksum is now a CRC-32C in
+ * hex (8 characters), but the buffer keeps its historical MD5 size since
+ * the filerep protocol embeds a buffer of this length in its messages.
+ */
 #define SLRU_MD5_BUFLEN			33     /* MD5 is 32 bytes + 1 null-terminator */
 
                            /* room for filename + ":" + " " + md5 hash + "\n" */
@@ -32,6 +39,25 @@
 
 #define SLRU_CKSUM_LINE_DELIM	"\n"
 
+/*
+ * The slot pool is carved into banks of SLRU_BANK_SIZE slots apiece, and
+ * each bank is protected by its own control lock.  A page may live only in
+ * the bank its page number maps to, so concurrent lookups of pages that
+ * hash to different banks never contend with each other.  The bank size is
+ * kept small enough that a bank's slot_meta[] entries span few cache
+ * lines, since we still search a bank linearly.  The number of banks (and
+ * hence the slot count) must be a power of two so the bank number can be
+ * computed with a mask.
+ */
+#define SLRU_BANK_SIZE			8
+
+/*
+ * Capacity of the deferred-fsync table in SlruSharedData.  Only segments
+ * dirtied by standalone page writes between two checkpoints land here, so
+ * a modest fixed size suffices; overflow just means an inline fsync.
+ */
+#define SLRU_MAX_PENDING_FSYNCS	32
+
 /*
  * Page status codes.  Note that these do not include the "dirty" bit.
  * page_dirty can be TRUE only in the VALID or WRITE_IN_PROGRESS states;
@@ -46,25 +72,52 @@ typedef enum
 	SLRU_PAGE_WRITE_IN_PROGRESS /* page is being written out */
 } SlruPageStatus;
 
+/*
+ * Hot per-slot metadata, packed into one small struct so that the lookup
+ * loops touch a single cache line per probed slot instead of pulling in a
+ * line apiece from parallel pageno/status/dirty/lru arrays.  At 12 bytes
+ * per entry, a whole bank's metadata fits in two cache lines.
+ *
+ * pageno and lru_count are undefined when status is SLRU_PAGE_EMPTY.
+ * status holds a SlruPageStatus value; it is a uint8 to keep the struct
+ * small.
+ */
+typedef struct SlruSlotMeta
+{
+	int			pageno;			/* page held in this slot */
+	uint8		status;			/* SlruPageStatus of the slot */
+	bool		dirty;			/* page needs writing before eviction */
+	int			lru_count;		/* see LRU-clock notes below */
+} SlruSlotMeta;
+
 /*
  * Shared-memory state
  */
 typedef struct SlruSharedData
 {
-	LWLockId	ControlLock;
-
 	/* Number of buffers managed by this SLRU structure */
 	int			num_slots;
 
 	/*
-	 * Arrays holding info for each buffer slot.  Page number is undefined
-	 * when status is EMPTY, as is page_lru_count.
+	 * The buffer slots are grouped into banks of SLRU_BANK_SIZE slots, each
+	 * bank protected by its own control lock.  A given page can be buffered
+	 * only in the bank selected by (pageno / SLRU_BANK_SIZE) & bank_mask,
+	 * so the bank lock for a page's bank must be held to examine or modify
+	 * any shared state relating to that page.  bank_mask is num_banks - 1
+	 * (num_banks is a power of 2).
+	 */
+	int			num_banks;
+	int			bank_mask;
+	LWLockId   *bank_locks;		/* one control lock per bank */
+	int		   *bank_cur_lru_count; /* one LRU clock per bank */
+
+	/*
+	 * Arrays holding info for each buffer slot.  The hot metadata lives
+	 * packed together in slot_meta[]; only the page contents and the I/O
+	 * locks are kept apart.
 	 */
 	char	  **page_buffer;
-	SlruPageStatus *page_status;
-	bool	   *page_dirty;
-	int		   *page_number;
-	int		   *page_lru_count;
+	SlruSlotMeta *slot_meta;
 	LWLockId   *buffer_locks;
 
 	/*
@@ -80,25 +133,67 @@ typedef struct SlruSharedData
 
 	/*----------
 	 * We mark a page "most recently used" by setting
-	 *		page_lru_count[slotno] = ++cur_lru_count;
-	 * The oldest page is therefore the one with the highest value of
-	 *		cur_lru_count - page_lru_count[slotno]
+	 *		slot_meta[slotno].lru_count = ++bank_cur_lru_count[bankno];
+	 * where bankno is the bank the slot belongs to.  The oldest page within
+	 * a bank is therefore the one with the highest value of
+	 *		bank_cur_lru_count[bankno] - slot_meta[slotno].lru_count
 	 * The counts will eventually wrap around, but this calculation still
 	 * works as long as no page's age exceeds INT_MAX counts.
+	 *
+	 * The clock is per bank (see bank_cur_lru_count above) so that the hit
+	 * path in SimpleLruReadPage_ReadOnly dirties only the cache line of its
+	 * own bank's counter rather than bouncing one global int between all
+	 * processors.  Victim selection only ever compares ages within a single
+	 * bank, so the clocks need no relationship to one another.
 	 *----------
 	 */
-	int			cur_lru_count;
+
+	/*
+	 * Segments that still owe an fsync from a standalone (eviction) page
+	 * write.  Instead of paying the fsync in the foreground while a bank
+	 * lock convoy builds up behind the evicting backend, the segment number
+	 * is recorded here and SimpleLruFlush absorbs the fsync into the next
+	 * checkpoint, which must fsync the recently-written segments anyway.
+	 * Protected by fsync_lck; if the table overflows, the writer just
+	 * fsyncs inline as before.
+	 */
+	slock_t		fsync_lck;
+	int			num_pending_fsyncs;
+	int			pending_fsync_segno[SLRU_MAX_PENDING_FSYNCS];
 
 	/*
 	 * latest_page_number is the page number of the current end of the log;
 	 * this is not critical data, since we use it only to avoid swapping out
-	 * the latest page.
+	 * the latest page.  It is read and written without any lock now that the
+	 * control lock is partitioned by bank; like the LRU counts above, we
+	 * rely on int reads and writes being atomic, and a slightly stale value
+	 * does no harm.
 	 */
 	int			latest_page_number;
 } SlruSharedData;
 
 typedef SlruSharedData *SlruShared;
 
+/*
+ * Number of recently used segment files kept open per SLRU area in each
+ * backend.  Opening and closing the segment around every page read costs
+ * two extra syscalls per miss; keeping a handful of fds open covers the
+ * access locality of the read path almost completely.
+ */
+#define SLRU_MAX_OPEN_SEGMENTS	8
+
+/*
+ * One entry of the per-backend segment fd cache (see SlruPhysicalReadPage).
+ */
+typedef struct SlruFdCacheEntry
+{
+	int			segno;			/* segment number, -1 if entry unused */
+	int			fd;				/* open file descriptor for the segment */
+	int			lru;			/* tick of last use, for eviction */
+	bool		advised_sequential;		/* already gave the kernel
+										 * POSIX_FADV_SEQUENTIAL? */
+} SlruFdCacheEntry;
+
 /*
  * SlruCtlData is an unshared structure that points to the active information
  * in shared memory.
@@ -107,6 +202,16 @@ typedef struct SlruCtlData
 {
 	SlruShared	shared;
 
+	/*
+	 * Per-backend cache of open segment files, used by the physical read
+	 * path.  Writes go through the mirrored flat-file layer and do not use
+	 * this cache.
+	 */
+	SlruFdCacheEntry fd_cache[SLRU_MAX_OPEN_SEGMENTS];
+	int			fd_cache_clock; /* LRU tick counter */
+	int			last_read_pageno;		/* last page physically read, for
+										 * detecting sequential scans */
+
 	/*
 	 * This flag tells whether to fsync writes (true for pg_clog and multixact
 	 * stuff, false for pg_subtrans).
@@ -125,6 +230,15 @@ typedef struct SlruCtlData
 	 * it's always the same, it doesn't need to be in shared memory.
 	 */
 	char		Dir[64];
+
+	/*
+	 * Dir resolved against the transaction filespace, memoized on first
+	 * physical I/O.  The filespace location of a segment is fixed for the
+	 * life of the postmaster, so each backend only pays the resolution
+	 * (string matching plus a palloc) once instead of on every I/O.
+	 */
+	char		resolvedDir[MAXPGPATH];
+	bool		dirResolved;
 } SlruCtlData;
 
 typedef SlruCtlData *SlruCtl;
@@ -135,7 +249,8 @@ typedef struct SlruFlushData *SlruFlush;
 
 extern Size SimpleLruShmemSize(int nslots, int nlsns);
 extern void SimpleLruInit(SlruCtl ctl, const char *name, int nslots, int nlsns,
-			  LWLockId ctllock, const char *subdir);
+			  const char *subdir);
+extern LWLockId SimpleLruGetBankLock(SlruCtl ctl, int pageno);
 extern int	SimpleLruZeroPage(SlruCtl ctl, int pageno);
 extern int SimpleLruReadPage(SlruCtl ctl, int pageno, bool write_ok,
 				  TransactionId xid);
@@ -144,12 +259,11 @@ extern int SimpleLruReadPage_ReadOnly(SlruCtl ctl, int pageno,
 extern void SimpleLruWritePage(SlruCtl ctl, int slotno, SlruFlush fdata);
 extern void SimpleLruFlush(SlruCtl ctl, bool checkpoint);
 extern void SimpleLruTruncate(SlruCtl ctl, int cutoffPage);
-extern void SimpleLruTruncateWithLock(SlruCtl ctl, int cutoffPage);
 extern bool SlruScanDirectory(SlruCtl ctl, int cutoffPage, bool doDeletions);
 extern bool SimpleLruPageExists(SlruCtl ctl, int pageno);
 extern int SlruRecoverMirror(void);
 extern int SlruCreateChecksumFile(const char *fullDirName);
 extern int SlruMirrorVerifyDirectoryChecksum(char *dirName, char *cksumFile,
-											 char *primaryMd5);
+											 char *primaryCksum);
 
 #endif   /* SLRU_H */
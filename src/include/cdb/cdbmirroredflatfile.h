@@ -119,6 +119,22 @@ extern int MirroredFlatFile_OpenInDbDir(
 	bool			suppressError);
 
 
+/*
+ * Start asynchronous writeback of the local side of a flat file.
+ */
+extern void MirroredFlatFile_StartWriteback(
+	MirroredFlatFileOpen *open);
+				/* The open struct. */
+
+/*
+ * Wait for the mirror's acknowledgement of a previously sent flush.
+ */
+extern void MirroredFlatFile_WaitForFlush(
+	char 			*subDirectory,
+
+	char			*simpleFileName);
+				/* The simple file name. */
+
 /*
  * Flush a flat file.
  */
@@ -272,6 +288,11 @@ extern int MirrorFlatFile(
 			   char 		*subDirectory,
 			   char			*simpleFileName);
 
+extern int MirrorFlatFileAsync(
+			   char 		*subDirectory,
+			   char			*simpleFileName,
+			   bool			*flushAckPending);
+
 extern void MirroredFlatFile_DropFilesFromDir(void);
 
 extern void MirroredFlatFile_DropTemporaryFiles(void);